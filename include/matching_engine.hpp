@@ -9,39 +9,70 @@
 
 namespace trading {
 
+// A single worker thread applies queued orders, so the book sees them in
+// exactly the order submitOrder sequenced them
 class MatchingEngine {
 public:
-    explicit MatchingEngine(size_t numThreads = std::thread::hardware_concurrency());
+    MatchingEngine();
     ~MatchingEngine();
 
     // Non-copyable
     MatchingEngine(const MatchingEngine&) = delete;
     MatchingEngine& operator=(const MatchingEngine&) = delete;
 
-    // Order submission interface
+    // Order submission interface. Cancels and replaces are queued behind
+    // earlier submissions; `sequence` receives their position in that order.
+    // Requests need a running engine: before start() or after stop() they are
+    // not sequenced and their futures resolve to false at once. stop() applies
+    // everything already sequenced before returning.
     std::future<bool> submitOrder(std::shared_ptr<Order> order);
-    bool cancelOrder(const std::string& orderId);
+    std::future<bool> cancelOrder(const std::string& orderId, uint64_t* sequence = nullptr);
+    std::future<bool> replaceOrder(const std::string& orderId, double newPrice, double newQuantity,
+                                   uint64_t* sequence = nullptr);
 
     // Engine control
     void start();
     void stop();
 
+    // Fills are reported in the order the book applies them; set before start()
+    void setFillListener(OrderBook::FillListener listener);
+    const OrderBook& getOrderBook() const { return orderBook_; }
+
     // Statistics and monitoring
     double getAverageLatencyMicros() const;
     uint64_t getOrdersProcessedPerSecond() const;
 
 private:
+    enum class RequestType {
+        SUBMIT,
+        CANCEL,
+        REPLACE
+    };
+
+    struct PendingRequest {
+        RequestType type;
+        std::shared_ptr<Order> order;   // SUBMIT
+        std::string orderId;            // CANCEL and REPLACE
+        double newPrice = 0.0;
+        double newQuantity = 0.0;
+        std::shared_ptr<std::promise<bool>> promise;
+    };
+
+    std::future<bool> enqueue(PendingRequest request, uint64_t* sequence);
     void processingThread();
+    bool processRequest(const PendingRequest& request);
     void processOrder(std::shared_ptr<Order> order);
+    bool handleReplace(const std::string& orderId, double newPrice, double newQuantity);
     void handleMarketOrder(std::shared_ptr<Order> order);
     void handleLimitOrder(std::shared_ptr<Order> order);
     void handleStopOrder(std::shared_ptr<Order> order);
 
     OrderBook orderBook_;
-    std::queue<std::shared_ptr<Order>> orderQueue_;
+    std::queue<PendingRequest> orderQueue_;
     std::mutex queueMutex_;
     std::condition_variable queueCV_;
-    std::vector<std::thread> workerThreads_;
+    uint64_t nextSequence_ = 0;  // Guarded by queueMutex_
+    std::thread workerThread_;
     std::atomic<bool> running_{false};
 
     // Performance metrics
@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include <chrono>
+#include <cstdint>
 
 namespace trading {
 
@@ -31,8 +32,11 @@ public:
     double getQuantity() const { return quantity_; }
     double getStopPrice() const { return stopPrice_; }
     std::chrono::system_clock::time_point getTimestamp() const { return timestamp_; }
+    uint64_t getSequence() const { return sequence_; }
 
     void setQuantity(double quantity) { quantity_ = quantity; }
+    void setPrice(double price) { price_ = price; }
+    void setSequence(uint64_t sequence) { sequence_ = sequence; }
 
 private:
     std::string orderId_;
@@ -42,5 +46,6 @@ private:
     double quantity_;
     double stopPrice_;
     std::chrono::system_clock::time_point timestamp_;
+    uint64_t sequence_ = 0;  // Assigned by MatchingEngine on submission
 };
 }
\ No newline at end of file
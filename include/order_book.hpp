@@ -5,10 +5,12 @@
 #include <list>
 #include <memory>
 #include <shared_mutex>
+#include <mutex>
 #include <atomic>
 #include <vector>
 #include <type_traits>
 #include <utility>
+#include <functional>
 
 namespace trading {
 
@@ -19,19 +21,47 @@ struct PriceLevel {
     std::list<std::shared_ptr<Order>> orders;
 };
 
+// Where an order lives, so cancel/replace can reach its queue node directly
+struct OrderLocation {
+    std::shared_ptr<Order> order;
+    std::list<std::shared_ptr<Order>>::iterator position;
+    bool inBook = false;  // false while a stop order is still untriggered
+};
+
 class OrderBook {
 public:
+    // Called under the book lock for every fill: aggressor, resting order,
+    // execution price and executed quantity
+    using FillListener = std::function<void(const Order&, const Order&, double, double)>;
+
     OrderBook();
     ~OrderBook() = default;
 
     // Order operations
     bool addOrder(std::shared_ptr<Order> order);
     bool cancelOrder(const std::string& orderId);
+    // Quantity-only replace at the order's current price
     bool modifyOrder(const std::string& orderId, double newQuantity);
 
+    // Cancel/replace in place. A size reduction at the same price keeps queue
+    // priority; a price change or size increase moves the order to the back of
+    // its (new) level. If the new price crosses, the order is matched first and
+    // the resulting fills are appended to `matches` when provided.
+    bool replaceOrder(const std::string& orderId, double newPrice, double newQuantity,
+                      std::vector<std::pair<std::shared_ptr<Order>, std::shared_ptr<Order>>>* matches = nullptr);
+
     // Market data accessors
     double getBestBid() const;
     double getBestAsk() const;
+
+    // Resting orders on one side, best level first and FIFO within a level
+    std::vector<std::shared_ptr<Order>> getOrders(OrderSide side) const;
+    size_t getStopOrderCount() const;
+    // Untriggered stops in trigger order: stop price, then time priority
+    std::vector<std::shared_ptr<Order>> getStopOrders() const;
+
+    // Not synchronised with matching; install before orders are submitted
+    void setFillListener(FillListener listener) { fillListener_ = std::move(listener); }
     
     // Trading operations
     std::vector<std::pair<std::shared_ptr<Order>, std::shared_ptr<Order>>> 
@@ -40,13 +70,25 @@ public:
     void checkStopOrders(double lastTradePrice);
 
 private:
+    // Helpers below expect mutex_ to be held by the caller
+    bool replaceOrderLocked(const std::string& orderId, double newPrice, double newQuantity,
+                            std::vector<std::pair<std::shared_ptr<Order>, std::shared_ptr<Order>>>* matches);
+    void restOrderLocked(const std::shared_ptr<Order>& order);
+    std::list<std::shared_ptr<Order>>& levelOrdersLocked(OrderSide side, double price);
+    void eraseLevelIfEmptyLocked(OrderSide side, double price);
+    void matchLocked(const std::shared_ptr<Order>& order,
+                     std::vector<std::pair<std::shared_ptr<Order>, std::shared_ptr<Order>>>& matches);
+
     std::map<double, PriceLevel, std::greater<double>> bids_;
     std::map<double, PriceLevel> asks_;
-    std::unordered_map<std::string, std::shared_ptr<Order>> orderMap_;
+    std::unordered_map<std::string, OrderLocation> orderMap_;
     std::multimap<double, std::shared_ptr<Order>> stopOrders_;
+    FillListener fillListener_;
     mutable std::shared_mutex mutex_;
     std::atomic<uint64_t> totalOrdersProcessed_{0};
     std::atomic<uint64_t> totalMatchesExecuted_{0};
     
     friend class MatchingEngine;
-};
\ No newline at end of file
+};
+
+} // namespace trading
\ No newline at end of file
@@ -20,7 +20,7 @@ double generatePrice(double basePrice, double variance, mt19937& gen) {
 }
 
 int main() {
-    // Create the matching engine with hardware thread count
+    // Create the matching engine; a single worker thread applies orders in sequence
     MatchingEngine engine;
     engine.start();
 
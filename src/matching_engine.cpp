@@ -3,52 +3,82 @@
 
 namespace trading {
 
-MatchingEngine::MatchingEngine(size_t numThreads) {
-    for (size_t i = 0; i < numThreads; ++i) {
-        workerThreads_.emplace_back(&MatchingEngine::processingThread, this);
-    }
+MatchingEngine::MatchingEngine() {
     startTime_ = std::chrono::steady_clock::now();
 }
 
 MatchingEngine::~MatchingEngine() {
     stop();
-    for (auto& thread : workerThreads_) {
-        if (thread.joinable()) {
-            thread.join();
-        }
-    }
 }
 
 void MatchingEngine::start() {
-    running_ = true;
+    if (running_.exchange(true)) return;
     startTime_ = std::chrono::steady_clock::now();
+    workerThread_ = std::thread(&MatchingEngine::processingThread, this);
 }
 
 void MatchingEngine::stop() {
-    running_ = false;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        running_ = false;
+    }
     queueCV_.notify_all();
+    if (workerThread_.joinable()) {
+        workerThread_.join();
+    }
 }
 
 std::future<bool> MatchingEngine::submitOrder(std::shared_ptr<Order> order) {
-    auto promise = std::make_shared<std::promise<bool>>();
-    auto future = promise->get_future();
+    PendingRequest request;
+    request.type = RequestType::SUBMIT;
+    request.order = std::move(order);
+    return enqueue(std::move(request), nullptr);
+}
+
+std::future<bool> MatchingEngine::cancelOrder(const std::string& orderId, uint64_t* sequence) {
+    PendingRequest request;
+    request.type = RequestType::CANCEL;
+    request.orderId = orderId;
+    return enqueue(std::move(request), sequence);
+}
+
+std::future<bool> MatchingEngine::replaceOrder(const std::string& orderId, double newPrice,
+                                               double newQuantity, uint64_t* sequence) {
+    PendingRequest request;
+    request.type = RequestType::REPLACE;
+    request.orderId = orderId;
+    request.newPrice = newPrice;
+    request.newQuantity = newQuantity;
+    return enqueue(std::move(request), sequence);
+}
+
+void MatchingEngine::setFillListener(OrderBook::FillListener listener) {
+    orderBook_.setFillListener(std::move(listener));
+}
+
+std::future<bool> MatchingEngine::enqueue(PendingRequest request, uint64_t* sequence) {
+    request.promise = std::make_shared<std::promise<bool>>();
+    auto future = request.promise->get_future();
     
     {
         std::lock_guard<std::mutex> lock(queueMutex_);
-        orderQueue_.push(order);
+        if (!running_) {
+            request.promise->set_value(false);
+            return future;
+        }
+        ++nextSequence_;
+        if (request.order) request.order->setSequence(nextSequence_);
+        if (sequence) *sequence = nextSequence_;
+        orderQueue_.push(std::move(request));
     }
     queueCV_.notify_one();
     
     return future;
 }
 
-bool MatchingEngine::cancelOrder(const std::string& orderId) {
-    return orderBook_.cancelOrder(orderId);
-}
-
 void MatchingEngine::processingThread() {
-    while (running_) {
-        std::shared_ptr<Order> order;
+    while (true) {
+        PendingRequest pending;
         
         {
             std::unique_lock<std::mutex> lock(queueMutex_);
@@ -56,22 +86,47 @@ void MatchingEngine::processingThread() {
                 return !orderQueue_.empty() || !running_; 
             });
             
-            if (!running_) break;
+            // Drain what was sequenced before stop() so every future resolves
+            if (orderQueue_.empty()) break;
             
-            order = orderQueue_.front();
+            pending = std::move(orderQueue_.front());
             orderQueue_.pop();
         }
         
-        if (order) {
-            auto start = std::chrono::high_resolution_clock::now();
-            processOrder(order);
-            auto end = std::chrono::high_resolution_clock::now();
-            
-            auto latency = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-            totalLatencyMicros_ += latency.count();
-            orderCount_++;
-        }
+        auto start = std::chrono::high_resolution_clock::now();
+        bool result = processRequest(pending);
+        auto end = std::chrono::high_resolution_clock::now();
+        
+        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+        totalLatencyMicros_ += latency.count();
+        orderCount_++;
+        pending.promise->set_value(result);
+    }
+}
+
+bool MatchingEngine::processRequest(const PendingRequest& request) {
+    switch (request.type) {
+        case RequestType::SUBMIT:
+            processOrder(request.order);
+            return true;
+        case RequestType::CANCEL:
+            return orderBook_.cancelOrder(request.orderId);
+        case RequestType::REPLACE:
+            return handleReplace(request.orderId, request.newPrice, request.newQuantity);
+    }
+    return false;
+}
+
+bool MatchingEngine::handleReplace(const std::string& orderId, double newPrice, double newQuantity) {
+    std::vector<std::pair<std::shared_ptr<Order>, std::shared_ptr<Order>>> matches;
+    if (!orderBook_.replaceOrder(orderId, newPrice, newQuantity, &matches)) {
+        return false;
+    }
+    if (!matches.empty()) {
+        double lastPrice = matches.back().second->getPrice();
+        orderBook_.checkStopOrders(lastPrice);
     }
+    return true;
 }
 
 void MatchingEngine::processOrder(std::shared_ptr<Order> order) {
@@ -99,14 +154,16 @@ void MatchingEngine::handleMarketOrder(std::shared_ptr<Order> order) {
 
 void MatchingEngine::handleLimitOrder(std::shared_ptr<Order> order) {
     auto matches = orderBook_.matchMarketOrder(order);
-    if (!matches.empty()) {
-        double lastPrice = matches.back().second->getPrice();
-        orderBook_.checkStopOrders(lastPrice);
-    }
     
+    // Rest the remainder first so triggered stops can trade against it
     if (order->getQuantity() > 0) {
         orderBook_.addOrder(order);
     }
+    
+    if (!matches.empty()) {
+        double lastPrice = matches.back().second->getPrice();
+        orderBook_.checkStopOrders(lastPrice);
+    }
 }
 
 void MatchingEngine::handleStopOrder(std::shared_ptr<Order> order) {
@@ -16,4 +16,6 @@ Order::Order(const std::string& orderId,
     , stopPrice_(stopPrice)
     , timestamp_(std::chrono::system_clock::now())
 {
-}
\ No newline at end of file
+}
+
+} // namespace trading
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "order_book.hpp"
 #include <algorithm>
+#include <iterator>
 
 namespace trading {
 
@@ -10,21 +11,11 @@ bool OrderBook::addOrder(std::shared_ptr<Order> order) {
     
     if (order->getType() == OrderType::STOP) {
         stopOrders_.emplace(order->getStopPrice(), order);
-        orderMap_[order->getOrderId()] = order;
+        orderMap_[order->getOrderId()] = OrderLocation{order, {}, false};
         return true;
     }
 
-    if (order->getSide() == OrderSide::BUY) {
-        auto& priceLevel = bids_[order->getPrice()];
-        priceLevel.price = order->getPrice();
-        priceLevel.orders.push_back(order);
-    } else {
-        auto& priceLevel = asks_[order->getPrice()];
-        priceLevel.price = order->getPrice();
-        priceLevel.orders.push_back(order);
-    }
-    
-    orderMap_[order->getOrderId()] = order;
+    restOrderLocked(order);
     totalOrdersProcessed_++;
     return true;
 }
@@ -34,45 +25,22 @@ bool OrderBook::cancelOrder(const std::string& orderId) {
     auto it = orderMap_.find(orderId);
     if (it == orderMap_.end()) return false;
 
-    auto order = it->second;
-    if (order->getType() == OrderType::STOP) {
+    auto order = it->second.order;
+    if (!it->second.inBook) {
         auto range = stopOrders_.equal_range(order->getStopPrice());
-        for (auto it = range.first; it != range.second; ++it) {
-            if (it->second->getOrderId() == orderId) {
-                stopOrders_.erase(it);
-                orderMap_.erase(orderId);
-                return true;
+        for (auto stopIt = range.first; stopIt != range.second; ++stopIt) {
+            if (stopIt->second->getOrderId() == orderId) {
+                stopOrders_.erase(stopIt);
+                break;
             }
         }
+        orderMap_.erase(it);
+        return true;
     }
 
-    if (order->getSide() == OrderSide::BUY) {
-        auto levelIt = bids_.find(order->getPrice());
-        if (levelIt != bids_.end()) {
-            auto& orders = levelIt->second.orders;
-            orders.remove_if([&orderId](const auto& o) { 
-                return o->getOrderId() == orderId; 
-            });
-            
-            if (orders.empty()) {
-                bids_.erase(levelIt);
-            }
-        }
-    } else {
-        auto levelIt = asks_.find(order->getPrice());
-        if (levelIt != asks_.end()) {
-            auto& orders = levelIt->second.orders;
-            orders.remove_if([&orderId](const auto& o) { 
-                return o->getOrderId() == orderId; 
-            });
-            
-            if (orders.empty()) {
-                asks_.erase(levelIt);
-            }
-        }
-    }
-    
-    orderMap_.erase(orderId);
+    levelOrdersLocked(order->getSide(), order->getPrice()).erase(it->second.position);
+    eraseLevelIfEmptyLocked(order->getSide(), order->getPrice());
+    orderMap_.erase(it);
     return true;
 }
 
@@ -81,8 +49,76 @@ bool OrderBook::modifyOrder(const std::string& orderId, double newQuantity) {
     auto it = orderMap_.find(orderId);
     if (it == orderMap_.end()) return false;
 
-    auto order = it->second;
+    // Same price never crosses, so there are no fills to report
+    return replaceOrderLocked(orderId, it->second.order->getPrice(), newQuantity, nullptr);
+}
+
+bool OrderBook::replaceOrder(const std::string& orderId, double newPrice, double newQuantity,
+                             std::vector<std::pair<std::shared_ptr<Order>, std::shared_ptr<Order>>>* matches) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    return replaceOrderLocked(orderId, newPrice, newQuantity, matches);
+}
+
+bool OrderBook::replaceOrderLocked(const std::string& orderId, double newPrice, double newQuantity,
+                                   std::vector<std::pair<std::shared_ptr<Order>, std::shared_ptr<Order>>>* matches) {
+    if (newQuantity <= 0) return false;
+
+    auto it = orderMap_.find(orderId);
+    if (it == orderMap_.end()) return false;
+
+    auto& location = it->second;
+    auto order = location.order;
+
+    // Untriggered stops queue by insertion order within their stop price, so a
+    // price change or size increase re-inserts them at the back of that range
+    if (!location.inBook) {
+        bool keepsPriority = newPrice == order->getPrice() && newQuantity <= order->getQuantity();
+        order->setPrice(newPrice);
+        order->setQuantity(newQuantity);
+        if (!keepsPriority) {
+            auto range = stopOrders_.equal_range(order->getStopPrice());
+            for (auto stopIt = range.first; stopIt != range.second; ++stopIt) {
+                if (stopIt->second == order) {
+                    stopOrders_.erase(stopIt);
+                    break;
+                }
+            }
+            stopOrders_.emplace(order->getStopPrice(), order);
+        }
+        return true;
+    }
+
+    double oldPrice = order->getPrice();
+    auto& oldOrders = levelOrdersLocked(order->getSide(), oldPrice);
+
+    if (newPrice == oldPrice) {
+        if (newQuantity > order->getQuantity()) {
+            oldOrders.splice(oldOrders.end(), oldOrders, location.position);
+        }
+        order->setQuantity(newQuantity);
+        return true;
+    }
+
+    // Detach the node without freeing it; the iterator stays valid across splices
+    std::list<std::shared_ptr<Order>> detached;
+    detached.splice(detached.end(), oldOrders, location.position);
+    eraseLevelIfEmptyLocked(order->getSide(), oldPrice);
+
+    order->setPrice(newPrice);
     order->setQuantity(newQuantity);
+
+    std::vector<std::pair<std::shared_ptr<Order>, std::shared_ptr<Order>>> fills;
+    matchLocked(order, fills);
+    if (matches) {
+        matches->insert(matches->end(), fills.begin(), fills.end());
+    }
+
+    if (order->getQuantity() > 0) {
+        auto& newOrders = levelOrdersLocked(order->getSide(), newPrice);
+        newOrders.splice(newOrders.end(), detached, location.position);
+    } else {
+        orderMap_.erase(it);
+    }
     return true;
 }
 
@@ -90,14 +126,47 @@ std::vector<std::pair<std::shared_ptr<Order>, std::shared_ptr<Order>>>
 OrderBook::matchMarketOrder(std::shared_ptr<Order> order) {
     std::unique_lock<std::shared_mutex> lock(mutex_);
     std::vector<std::pair<std::shared_ptr<Order>, std::shared_ptr<Order>>> matches;
-    
+    matchLocked(order, matches);
+    return matches;
+}
+
+void OrderBook::restOrderLocked(const std::shared_ptr<Order>& order) {
+    auto& orders = levelOrdersLocked(order->getSide(), order->getPrice());
+    orders.push_back(order);
+    orderMap_[order->getOrderId()] = OrderLocation{order, std::prev(orders.end()), true};
+}
+
+std::list<std::shared_ptr<Order>>& OrderBook::levelOrdersLocked(OrderSide side, double price) {
+    auto& priceLevel = side == OrderSide::BUY ? bids_[price] : asks_[price];
+    priceLevel.price = price;
+    return priceLevel.orders;
+}
+
+void OrderBook::eraseLevelIfEmptyLocked(OrderSide side, double price) {
+    if (side == OrderSide::BUY) {
+        auto levelIt = bids_.find(price);
+        if (levelIt != bids_.end() && levelIt->second.orders.empty()) {
+            bids_.erase(levelIt);
+        }
+    } else {
+        auto levelIt = asks_.find(price);
+        if (levelIt != asks_.end() && levelIt->second.orders.empty()) {
+            asks_.erase(levelIt);
+        }
+    }
+}
+
+void OrderBook::matchLocked(const std::shared_ptr<Order>& order,
+                            std::vector<std::pair<std::shared_ptr<Order>, std::shared_ptr<Order>>>& matches) {
     double remainingQty = order->getQuantity();
+    bool hasLimit = order->getType() != OrderType::MARKET;
+    double limitPrice = order->getPrice();
     
     if (order->getSide() == OrderSide::BUY) {
         // For buy orders, match against asks
         for (auto bookIt = asks_.begin(); 
              bookIt != asks_.end() && remainingQty > 0;) {
-            // Rest of the matching logic
+            if (hasLimit && bookIt->first > limitPrice) break;
             auto& priceLevel = bookIt->second;
             
             for (auto orderIt = priceLevel.orders.begin(); 
@@ -106,6 +175,9 @@ OrderBook::matchMarketOrder(std::shared_ptr<Order> order) {
                 double matchQty = std::min(remainingQty, matchedOrder->getQuantity());
                 
                 matches.emplace_back(order, matchedOrder);
+                if (fillListener_) {
+                    fillListener_(*order, *matchedOrder, matchedOrder->getPrice(), matchQty);
+                }
                 remainingQty -= matchQty;
                 matchedOrder->setQuantity(matchedOrder->getQuantity() - matchQty);
                 
@@ -128,6 +200,7 @@ OrderBook::matchMarketOrder(std::shared_ptr<Order> order) {
         // For sell orders, match against bids
         for (auto bookIt = bids_.begin(); 
              bookIt != bids_.end() && remainingQty > 0;) {
+            if (hasLimit && bookIt->first < limitPrice) break;
             auto& priceLevel = bookIt->second;
             
             for (auto orderIt = priceLevel.orders.begin(); 
@@ -136,6 +209,9 @@ OrderBook::matchMarketOrder(std::shared_ptr<Order> order) {
                 double matchQty = std::min(remainingQty, matchedOrder->getQuantity());
                 
                 matches.emplace_back(order, matchedOrder);
+                if (fillListener_) {
+                    fillListener_(*order, *matchedOrder, matchedOrder->getPrice(), matchQty);
+                }
                 remainingQty -= matchQty;
                 matchedOrder->setQuantity(matchedOrder->getQuantity() - matchQty);
                 
@@ -156,34 +232,53 @@ OrderBook::matchMarketOrder(std::shared_ptr<Order> order) {
         }
     }
     
-    return matches;
+    order->setQuantity(remainingQty);
 }
 
 void OrderBook::checkStopOrders(double lastTradePrice) {
     std::unique_lock<std::shared_mutex> lock(mutex_);
-    std::vector<std::shared_ptr<Order>> triggeredOrders;
     
-    auto it = stopOrders_.begin();
-    while (it != stopOrders_.end()) {
-        auto order = it->second;
-        bool shouldTrigger = false;
+    // Triggered stops trade like limit orders at their limit price; their own
+    // fills can trigger further stops, so keep going until a pass is quiet
+    while (true) {
+        std::vector<std::shared_ptr<Order>> triggeredOrders;
         
-        if (order->getSide() == OrderSide::BUY && lastTradePrice >= order->getStopPrice()) {
-            shouldTrigger = true;
-        } else if (order->getSide() == OrderSide::SELL && lastTradePrice <= order->getStopPrice()) {
-            shouldTrigger = true;
+        auto it = stopOrders_.begin();
+        while (it != stopOrders_.end()) {
+            auto order = it->second;
+            bool shouldTrigger = false;
+            
+            if (order->getSide() == OrderSide::BUY && lastTradePrice >= order->getStopPrice()) {
+                shouldTrigger = true;
+            } else if (order->getSide() == OrderSide::SELL && lastTradePrice <= order->getStopPrice()) {
+                shouldTrigger = true;
+            }
+            
+            if (shouldTrigger) {
+                triggeredOrders.push_back(order);
+                it = stopOrders_.erase(it);
+            } else {
+                ++it;
+            }
         }
         
-        if (shouldTrigger) {
-            triggeredOrders.push_back(order);
-            it = stopOrders_.erase(it);
-        } else {
-            ++it;
+        if (triggeredOrders.empty()) break;
+        
+        // Already holding mutex_, so match and rest directly rather than
+        // re-entering addOrder (which would also park them as stops again)
+        std::vector<std::pair<std::shared_ptr<Order>, std::shared_ptr<Order>>> matches;
+        for (auto& order : triggeredOrders) {
+            matchLocked(order, matches);
+            if (order->getQuantity() > 0) {
+                restOrderLocked(order);
+            } else {
+                orderMap_.erase(order->getOrderId());
+            }
+            totalOrdersProcessed_++;
         }
-    }
-    
-    for (auto& order : triggeredOrders) {
-        addOrder(order);
+        
+        if (matches.empty()) break;
+        lastTradePrice = matches.back().second->getPrice();
     }
 }
 
@@ -197,4 +292,35 @@ double OrderBook::getBestAsk() const {
     return asks_.empty() ? 0.0 : asks_.begin()->first;
 }
 
+std::vector<std::shared_ptr<Order>> OrderBook::getOrders(OrderSide side) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    std::vector<std::shared_ptr<Order>> orders;
+    
+    if (side == OrderSide::BUY) {
+        for (const auto& [price, priceLevel] : bids_) {
+            orders.insert(orders.end(), priceLevel.orders.begin(), priceLevel.orders.end());
+        }
+    } else {
+        for (const auto& [price, priceLevel] : asks_) {
+            orders.insert(orders.end(), priceLevel.orders.begin(), priceLevel.orders.end());
+        }
+    }
+    return orders;
+}
+
+std::vector<std::shared_ptr<Order>> OrderBook::getStopOrders() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    std::vector<std::shared_ptr<Order>> orders;
+    orders.reserve(stopOrders_.size());
+    for (const auto& [stopPrice, order] : stopOrders_) {
+        orders.push_back(order);
+    }
+    return orders;
+}
+
+size_t OrderBook::getStopOrderCount() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return stopOrders_.size();
+}
+
 } // namespace trading
\ No newline at end of file
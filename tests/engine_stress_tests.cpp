@@ -0,0 +1,422 @@
+#include "../include/matching_engine.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace trading;
+
+// Usage: engine_stress_tests [producers] [requestsPerProducer] [seed]
+// Producers submit, cancel and replace concurrently; the sequence numbers
+// assigned by the engine define the input order replayed through ReferenceBook.
+
+struct OrderSpec {
+    std::string id;
+    OrderType type;
+    OrderSide side;
+    double price;
+    double quantity;
+    double stopPrice;
+};
+
+enum class Action {
+    SUBMIT,
+    CANCEL,
+    REPLACE
+};
+
+struct Request {
+    Action action;
+    OrderSpec order;        // SUBMIT
+    std::string targetId;   // CANCEL and REPLACE
+    double newPrice = 0.0;
+    double newQuantity = 0.0;
+    uint64_t sequence = 0;
+    std::shared_ptr<Order> submitted;
+    std::future<bool> result;
+};
+
+struct Fill {
+    std::string aggressorId;
+    std::string restingId;
+    double price;
+    double quantity;
+
+    bool operator==(const Fill& other) const {
+        return aggressorId == other.aggressorId && restingId == other.restingId &&
+               price == other.price && quantity == other.quantity;
+    }
+};
+
+// Deliberately naive: linear scans over arrival-ordered vectors. Rules: price
+// then arrival priority, limit prices respected, market remainders dropped, a
+// limit remainder rests before any stops fire, and triggered stops (ordered by
+// stop price) trade as limit orders, possibly triggering further stops. A
+// replace, of a resting order or a parked stop, keeps its place only when
+// shrinking at the same price; otherwise it goes to the back, and a resting
+// order trades first if the new price crosses.
+class ReferenceBook {
+public:
+    bool apply(const Request& request) {
+        switch (request.action) {
+            case Action::SUBMIT:
+                submit(request.order);
+                return true;
+            case Action::CANCEL:
+                return cancel(request.targetId);
+            case Action::REPLACE:
+                return replace(request.targetId, request.newPrice, request.newQuantity);
+        }
+        return false;
+    }
+
+    void submit(OrderSpec order) {
+        size_t fillsBefore = fills_.size();
+        switch (order.type) {
+            case OrderType::MARKET:
+                match(order, false);
+                break;
+            case OrderType::LIMIT:
+                match(order, true);
+                if (order.quantity > 0) {
+                    book(order.side).push_back(order);
+                }
+                break;
+            case OrderType::STOP:
+                stops_.push_back(order);
+                break;
+        }
+        if (fills_.size() > fillsBefore) {
+            runStops(fills_.back().price);
+        }
+    }
+
+    // Resting orders best price first, arrival order within a price
+    std::vector<OrderSpec> resting(OrderSide side) const {
+        auto orders = side == OrderSide::BUY ? bids_ : asks_;
+        std::stable_sort(orders.begin(), orders.end(), [side](const auto& a, const auto& b) {
+            return side == OrderSide::BUY ? a.price > b.price : a.price < b.price;
+        });
+        return orders;
+    }
+
+    bool cancel(const std::string& id) {
+        for (auto* orders : {&bids_, &asks_, &stops_}) {
+            auto it = find(*orders, id);
+            if (it != orders->end()) {
+                orders->erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool replace(const std::string& id, double newPrice, double newQuantity) {
+        if (newQuantity <= 0) return false;
+
+        auto stopIt = find(stops_, id);
+        if (stopIt != stops_.end()) {
+            bool keepsPriority = newPrice == stopIt->price && newQuantity <= stopIt->quantity;
+            stopIt->price = newPrice;
+            stopIt->quantity = newQuantity;
+            if (!keepsPriority) {
+                OrderSpec stop = *stopIt;
+                stops_.erase(stopIt);
+                stops_.push_back(stop);
+            }
+            return true;
+        }
+
+        for (auto* orders : {&bids_, &asks_}) {
+            auto it = find(*orders, id);
+            if (it == orders->end()) continue;
+
+            if (newPrice == it->price && newQuantity <= it->quantity) {
+                it->quantity = newQuantity;
+                return true;
+            }
+
+            OrderSpec order = *it;
+            orders->erase(it);
+            order.quantity = newQuantity;
+            if (newPrice == order.price) {
+                orders->push_back(order);
+                return true;
+            }
+
+            order.price = newPrice;
+            size_t fillsBefore = fills_.size();
+            match(order, true);
+            if (order.quantity > 0) {
+                orders->push_back(order);
+            }
+            if (fills_.size() > fillsBefore) {
+                runStops(fills_.back().price);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // Parked stops in trigger order: stop price, then time priority
+    std::vector<OrderSpec> parkedStops() const {
+        auto orders = stops_;
+        std::stable_sort(orders.begin(), orders.end(), [](const auto& a, const auto& b) {
+            return a.stopPrice < b.stopPrice;
+        });
+        return orders;
+    }
+    const std::vector<Fill>& fills() const { return fills_; }
+
+private:
+    static std::vector<OrderSpec>::iterator find(std::vector<OrderSpec>& orders, const std::string& id) {
+        return std::find_if(orders.begin(), orders.end(), [&id](const auto& o) { return o.id == id; });
+    }
+
+    std::vector<OrderSpec>& book(OrderSide side) {
+        return side == OrderSide::BUY ? bids_ : asks_;
+    }
+
+    void match(OrderSpec& order, bool hasLimit) {
+        auto& opposite = book(order.side == OrderSide::BUY ? OrderSide::SELL : OrderSide::BUY);
+
+        while (order.quantity > 0 && !opposite.empty()) {
+            size_t best = 0;
+            for (size_t i = 1; i < opposite.size(); ++i) {
+                bool better = order.side == OrderSide::BUY
+                    ? opposite[i].price < opposite[best].price
+                    : opposite[i].price > opposite[best].price;
+                if (better) best = i;
+            }
+
+            auto& resting = opposite[best];
+            if (hasLimit && (order.side == OrderSide::BUY ? resting.price > order.price
+                                                          : resting.price < order.price)) {
+                break;
+            }
+
+            double qty = std::min(order.quantity, resting.quantity);
+            fills_.push_back(Fill{order.id, resting.id, resting.price, qty});
+            order.quantity -= qty;
+            resting.quantity -= qty;
+            if (resting.quantity <= 0) {
+                opposite.erase(opposite.begin() + best);
+            }
+        }
+    }
+
+    void runStops(double lastTradePrice) {
+        while (true) {
+            std::vector<OrderSpec> triggered;
+            std::vector<OrderSpec> remaining;
+            for (const auto& stop : stops_) {
+                bool fire = stop.side == OrderSide::BUY ? lastTradePrice >= stop.stopPrice
+                                                        : lastTradePrice <= stop.stopPrice;
+                (fire ? triggered : remaining).push_back(stop);
+            }
+            stops_.swap(remaining);
+            if (triggered.empty()) break;
+
+            std::stable_sort(triggered.begin(), triggered.end(), [](const auto& a, const auto& b) {
+                return a.stopPrice < b.stopPrice;
+            });
+
+            size_t fillsBefore = fills_.size();
+            for (auto& order : triggered) {
+                match(order, true);
+                if (order.quantity > 0) {
+                    book(order.side).push_back(order);
+                }
+            }
+            if (fills_.size() == fillsBefore) break;
+            lastTradePrice = fills_.back().price;
+        }
+    }
+
+    std::vector<OrderSpec> bids_;
+    std::vector<OrderSpec> asks_;
+    std::vector<OrderSpec> stops_;
+    std::vector<Fill> fills_;
+};
+
+Request randomRequest(const std::string& id, const std::vector<std::string>& ownIds, std::mt19937& gen) {
+    // Prices on a quarter tick and whole quantities keep double arithmetic exact
+    std::uniform_int_distribution<> actionDis(0, 19);
+    std::uniform_int_distribution<> sideDis(0, 1);
+    std::uniform_int_distribution<> tickDis(-20, 20);
+    std::uniform_int_distribution<> qtyDis(1, 100);
+
+    Request request;
+    int roll = actionDis(gen);
+    if (roll >= 15 && !ownIds.empty()) {
+        // Recent orders are the ones most likely to still be live
+        size_t window = std::min<size_t>(ownIds.size(), 8);
+        std::uniform_int_distribution<size_t> targetDis(ownIds.size() - window, ownIds.size() - 1);
+        request.action = roll < 17 ? Action::CANCEL : Action::REPLACE;
+        request.targetId = ownIds[targetDis(gen)];
+        if (request.action == Action::REPLACE) {
+            request.newPrice = 100.0 + tickDis(gen) * 0.25;
+            request.newQuantity = qtyDis(gen);
+        }
+        return request;
+    }
+
+    OrderType type = roll < 10 ? OrderType::LIMIT : (roll < 13 ? OrderType::MARKET : OrderType::STOP);
+    OrderSide side = sideDis(gen) == 0 ? OrderSide::BUY : OrderSide::SELL;
+    double price = type == OrderType::MARKET ? 0.0 : 100.0 + tickDis(gen) * 0.25;
+    // Stops sit on a few ticks away from the mid so they accumulate and share
+    // stop prices, which exercises their time priority when they trigger
+    std::uniform_int_distribution<> stopTickDis(14, 18);
+    double stopOffset = stopTickDis(gen) * 0.25;
+    double stopPrice = type != OrderType::STOP ? 0.0
+                     : side == OrderSide::BUY ? 100.0 + stopOffset : 100.0 - stopOffset;
+
+    request.action = Action::SUBMIT;
+    request.order = OrderSpec{id, type, side, price, static_cast<double>(qtyDis(gen)), stopPrice};
+    return request;
+}
+
+bool check(bool condition, const std::string& message) {
+    if (!condition) {
+        std::cerr << "Mismatch: " << message << "\n";
+    }
+    return condition;
+}
+
+bool compareOrders(const std::vector<std::shared_ptr<Order>>& actual,
+                   const std::vector<OrderSpec>& expected, const std::string& name) {
+    if (!check(actual.size() == expected.size(),
+               name + " depth " + std::to_string(actual.size()) +
+               " != " + std::to_string(expected.size()))) {
+        return false;
+    }
+    for (size_t i = 0; i < actual.size(); ++i) {
+        if (!check(actual[i]->getOrderId() == expected[i].id &&
+                   actual[i]->getPrice() == expected[i].price &&
+                   actual[i]->getQuantity() == expected[i].quantity,
+                   name + " entry " + std::to_string(i) + ": " +
+                   actual[i]->getOrderId() + " vs " + expected[i].id)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    size_t producers = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 8;
+    size_t requestsPerProducer = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000;
+    unsigned seed = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 12345;
+
+    MatchingEngine engine;
+    std::mutex fillsMutex;
+    std::vector<Fill> engineFills;
+    engine.setFillListener([&](const Order& aggressor, const Order& resting, double price, double qty) {
+        std::lock_guard<std::mutex> lock(fillsMutex);
+        engineFills.push_back(Fill{aggressor.getOrderId(), resting.getOrderId(), price, qty});
+    });
+    engine.start();
+
+    std::vector<std::vector<Request>> requests(producers);
+    std::vector<std::thread> threads;
+
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            std::mt19937 gen(seed + static_cast<unsigned>(p));
+            std::vector<std::string> ownIds;
+            for (size_t i = 0; i < requestsPerProducer; ++i) {
+                auto request = randomRequest("p" + std::to_string(p) + "_" + std::to_string(i), ownIds, gen);
+                switch (request.action) {
+                    case Action::SUBMIT: {
+                        const auto& spec = request.order;
+                        request.submitted = std::make_shared<Order>(
+                            spec.id, spec.type, spec.side, spec.price, spec.quantity, spec.stopPrice);
+                        ownIds.push_back(spec.id);
+                        request.result = engine.submitOrder(request.submitted);
+                        break;
+                    }
+                    case Action::CANCEL:
+                        request.result = engine.cancelOrder(request.targetId, &request.sequence);
+                        break;
+                    case Action::REPLACE:
+                        request.result = engine.replaceOrder(
+                            request.targetId, request.newPrice, request.newQuantity, &request.sequence);
+                        break;
+                }
+                requests[p].push_back(std::move(request));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Replay the exact sequence the engine accepted
+    std::vector<std::pair<Request*, bool>> sequenced;
+    for (auto& producerRequests : requests) {
+        for (auto& request : producerRequests) {
+            bool result = request.result.get();
+            if (request.submitted) {
+                request.sequence = request.submitted->getSequence();
+            }
+            sequenced.emplace_back(&request, result);
+        }
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::sort(sequenced.begin(), sequenced.end(), [](const auto& a, const auto& b) {
+        return a.first->sequence < b.first->sequence;
+    });
+
+    ReferenceBook reference;
+    bool ok = true;
+    size_t amendments = 0;
+    size_t amendmentsApplied = 0;
+    for (const auto& [request, engineResult] : sequenced) {
+        bool expected = reference.apply(*request);
+        if (request->action != Action::SUBMIT) {
+            amendments++;
+            amendmentsApplied += engineResult ? 1 : 0;
+        }
+        if (ok) {
+            ok = check(engineResult == expected,
+                       "result of request " + std::to_string(request->sequence) + " on " +
+                       (request->submitted ? request->order.id : request->targetId));
+        }
+    }
+
+    const auto& expectedFills = reference.fills();
+    ok &= check(engineFills.size() == expectedFills.size(),
+                "fill count " + std::to_string(engineFills.size()) +
+                " != " + std::to_string(expectedFills.size()));
+    for (size_t i = 0; ok && i < engineFills.size(); ++i) {
+        ok &= check(engineFills[i] == expectedFills[i],
+                    "fill " + std::to_string(i) + ": " + engineFills[i].aggressorId + "/" +
+                    engineFills[i].restingId + " vs " + expectedFills[i].aggressorId + "/" +
+                    expectedFills[i].restingId);
+    }
+    const auto& book = engine.getOrderBook();
+    ok = ok && compareOrders(book.getOrders(OrderSide::BUY), reference.resting(OrderSide::BUY), "bids");
+    ok = ok && compareOrders(book.getOrders(OrderSide::SELL), reference.resting(OrderSide::SELL), "asks");
+    ok = ok && compareOrders(book.getStopOrders(), reference.parkedStops(), "stops");
+
+    engine.stop();
+
+    std::cout << "Requests: " << sequenced.size() << " from " << producers << " producers\n";
+    std::cout << "Fills: " << engineFills.size() << "\n";
+    std::cout << "Cancels/replaces applied: " << amendmentsApplied << " of " << amendments << "\n";
+    std::cout << "Throughput: " << static_cast<uint64_t>(sequenced.size() / elapsed) << " requests/second\n";
+    std::cout << "Average latency: " << engine.getAverageLatencyMicros() << " microseconds\n";
+
+    if (!ok) {
+        std::cerr << "Engine stress test failed (seed " << seed << ")\n";
+        return 1;
+    }
+    std::cout << "Engine stress test passed\n";
+    return 0;
+}
@@ -53,13 +53,33 @@ void testStopOrderTrigger() {
     book.addOrder(stopOrder);
     
     // Simulate price movement
-    book.checkStopOrders(101.0);  // This should trigger the stop order
+    book.checkStopOrders(99.0);  // Falling through the stop price should trigger the sell stop
     
     assert(book.getBestAsk() == 95.0);  // The stop order should now be a limit order
     
     std::cout << "Stop order trigger test passed\n";
 }
 
+void testTriggeredStopMatches() {
+    OrderBook book;
+    
+    auto buy = std::make_shared<Order>("buy1", OrderType::LIMIT, OrderSide::BUY, 100.0, 10);
+    auto stopOrder = std::make_shared<Order>("stop1", OrderType::STOP, OrderSide::SELL, 95.0, 4, 100.0);
+    book.addOrder(buy);
+    book.addOrder(stopOrder);
+    
+    // The triggered sell crosses the resting bid instead of resting at 95
+    book.checkStopOrders(99.0);
+    
+    assert(buy->getQuantity() == 6);
+    assert(stopOrder->getQuantity() == 0);
+    assert(book.getBestBid() == 100.0);
+    assert(book.getBestAsk() == 0.0);
+    assert(!book.cancelOrder("stop1"));
+    
+    std::cout << "Triggered stop matches test passed\n";
+}
+
 void testMultiLevelOrderBook() {
     OrderBook book;
     
@@ -75,12 +95,206 @@ void testMultiLevelOrderBook() {
     std::cout << "Multi-level order book test passed\n";
 }
 
+void testReplaceKeepsPriorityOnReduce() {
+    OrderBook book;
+    
+    auto sell1 = std::make_shared<Order>("sell1", OrderType::LIMIT, OrderSide::SELL, 100.0, 10);
+    auto sell2 = std::make_shared<Order>("sell2", OrderType::LIMIT, OrderSide::SELL, 100.0, 10);
+    book.addOrder(sell1);
+    book.addOrder(sell2);
+    
+    // Shrinking in place keeps sell1 at the front of the queue
+    assert(book.replaceOrder("sell1", 100.0, 4));
+    assert(sell1->getQuantity() == 4);
+    
+    auto buy = std::make_shared<Order>("buy1", OrderType::MARKET, OrderSide::BUY, 0.0, 1);
+    auto matches = book.matchMarketOrder(buy);
+    assert(matches.size() == 1);
+    assert(matches[0].second->getOrderId() == "sell1");
+    
+    std::cout << "Replace keeps priority on reduce test passed\n";
+}
+
+void testReplaceLosesPriority() {
+    OrderBook book;
+    
+    auto sell1 = std::make_shared<Order>("sell1", OrderType::LIMIT, OrderSide::SELL, 100.0, 10);
+    auto sell2 = std::make_shared<Order>("sell2", OrderType::LIMIT, OrderSide::SELL, 100.0, 10);
+    book.addOrder(sell1);
+    book.addOrder(sell2);
+    
+    // A size increase sends sell1 to the back of its level
+    assert(book.replaceOrder("sell1", 100.0, 15));
+    auto buy = std::make_shared<Order>("buy1", OrderType::MARKET, OrderSide::BUY, 0.0, 1);
+    auto matches = book.matchMarketOrder(buy);
+    assert(matches[0].second->getOrderId() == "sell2");
+    
+    // A price change moves the order to a new level and clears the old one
+    assert(book.replaceOrder("sell2", 101.0, 9));
+    assert(book.getBestAsk() == 100.0);
+    assert(book.replaceOrder("sell1", 102.0, 15));
+    assert(book.getBestAsk() == 101.0);
+    
+    assert(!book.replaceOrder("missing", 100.0, 1));
+    assert(!book.replaceOrder("sell1", 100.0, 0));
+    
+    // modifyOrder follows the same rules and rejects empty sizes
+    assert(!book.modifyOrder("sell2", 0));
+    assert(sell2->getQuantity() == 9);
+    assert(book.modifyOrder("sell2", 3));
+    assert(sell2->getQuantity() == 3);
+    
+    std::cout << "Replace loses priority test passed\n";
+}
+
+void testReplaceCrossesAndMatches() {
+    OrderBook book;
+    
+    auto sell = std::make_shared<Order>("sell1", OrderType::LIMIT, OrderSide::SELL, 101.0, 5);
+    auto buy = std::make_shared<Order>("buy1", OrderType::LIMIT, OrderSide::BUY, 99.0, 8);
+    book.addOrder(sell);
+    book.addOrder(buy);
+    
+    // Repricing the bid through the ask trades, then rests the remainder
+    std::vector<std::pair<std::shared_ptr<Order>, std::shared_ptr<Order>>> matches;
+    assert(book.replaceOrder("buy1", 101.0, 8, &matches));
+    assert(matches.size() == 1);
+    assert(matches[0].second->getOrderId() == "sell1");
+    assert(buy->getQuantity() == 3);
+    assert(book.getBestAsk() == 0.0);
+    assert(book.getBestBid() == 101.0);
+    
+    // The resting remainder is still reachable by id
+    assert(book.cancelOrder("buy1"));
+    assert(book.getBestBid() == 0.0);
+    
+    std::cout << "Replace crosses and matches test passed\n";
+}
+
+void testReplaceUntriggeredStop() {
+    OrderBook book;
+    
+    auto stopOrder = std::make_shared<Order>("stop1", OrderType::STOP, OrderSide::SELL, 95.0, 10, 100.0);
+    book.addOrder(stopOrder);
+    
+    // Still parked: price and size change without touching the book
+    assert(book.replaceOrder("stop1", 96.0, 4));
+    assert(book.getStopOrderCount() == 1);
+    assert(book.getBestAsk() == 0.0);
+    
+    book.checkStopOrders(99.0);
+    assert(book.getStopOrderCount() == 0);
+    assert(book.getBestAsk() == 96.0);
+    assert(stopOrder->getQuantity() == 4);
+    
+    std::cout << "Replace untriggered stop test passed\n";
+}
+
+void testReplaceStopPriority() {
+    // Growing stop1 sends it behind stop2 at the same stop price
+    {
+        OrderBook book;
+        auto buy = std::make_shared<Order>("buy1", OrderType::LIMIT, OrderSide::BUY, 100.0, 5);
+        auto stop1 = std::make_shared<Order>("stop1", OrderType::STOP, OrderSide::SELL, 95.0, 5, 100.0);
+        auto stop2 = std::make_shared<Order>("stop2", OrderType::STOP, OrderSide::SELL, 95.0, 5, 100.0);
+        book.addOrder(buy);
+        book.addOrder(stop1);
+        book.addOrder(stop2);
+        
+        assert(book.replaceOrder("stop1", 95.0, 6));
+        book.checkStopOrders(99.0);
+        
+        assert(stop2->getQuantity() == 0);
+        assert(stop1->getQuantity() == 6);
+        assert(book.getBestAsk() == 95.0);
+    }
+    
+    // Shrinking stop1 keeps it ahead of stop2
+    {
+        OrderBook book;
+        auto buy = std::make_shared<Order>("buy1", OrderType::LIMIT, OrderSide::BUY, 100.0, 4);
+        auto stop1 = std::make_shared<Order>("stop1", OrderType::STOP, OrderSide::SELL, 95.0, 5, 100.0);
+        auto stop2 = std::make_shared<Order>("stop2", OrderType::STOP, OrderSide::SELL, 95.0, 5, 100.0);
+        book.addOrder(buy);
+        book.addOrder(stop1);
+        book.addOrder(stop2);
+        
+        assert(book.replaceOrder("stop1", 95.0, 4));
+        book.checkStopOrders(99.0);
+        
+        assert(stop1->getQuantity() == 0);
+        assert(stop2->getQuantity() == 5);
+    }
+    
+    std::cout << "Replace stop priority test passed\n";
+}
+
+void testEngineReplaceTriggersStops() {
+    MatchingEngine engine;
+    engine.start();
+    
+    engine.submitOrder(std::make_shared<Order>("sell1", OrderType::LIMIT, OrderSide::SELL, 101.0, 5)).wait();
+    engine.submitOrder(std::make_shared<Order>("buy1", OrderType::LIMIT, OrderSide::BUY, 99.0, 5)).wait();
+    engine.submitOrder(std::make_shared<Order>("stop1", OrderType::STOP, OrderSide::BUY, 100.0, 3, 101.0)).wait();
+    
+    // The repriced bid trades at 101, which fires the buy stop
+    assert(engine.replaceOrder("buy1", 101.0, 5).get());
+    
+    const auto& book = engine.getOrderBook();
+    assert(book.getStopOrderCount() == 0);
+    assert(book.getBestAsk() == 0.0);
+    assert(book.getBestBid() == 100.0);
+    
+    // Cancels are sequenced too; buy1 was fully filled by the replace
+    assert(!engine.cancelOrder("buy1").get());
+    assert(engine.cancelOrder("stop1").get());
+    assert(book.getBestBid() == 0.0);
+    
+    engine.stop();
+    
+    std::cout << "Engine replace triggers stops test passed\n";
+}
+
+void testEngineStopDrainsQueue() {
+    MatchingEngine engine;
+    
+    // Not running yet: rejected immediately rather than left pending
+    assert(!engine.submitOrder(std::make_shared<Order>("early", OrderType::LIMIT, OrderSide::BUY, 99.0, 1)).get());
+    assert(!engine.cancelOrder("early").get());
+    
+    engine.start();
+    std::vector<std::future<bool>> results;
+    for (int i = 0; i < 100; ++i) {
+        results.push_back(engine.submitOrder(std::make_shared<Order>(
+            "buy" + std::to_string(i), OrderType::LIMIT, OrderSide::BUY, 99.0, 1)));
+    }
+    results.push_back(engine.cancelOrder("buy0"));
+    engine.stop();
+    
+    // Everything sequenced before stop() was applied
+    for (auto& result : results) {
+        assert(result.get());
+    }
+    assert(engine.getOrderBook().getOrders(OrderSide::BUY).size() == 99);
+    assert(!engine.replaceOrder("buy1", 98.0, 1).get());
+    
+    std::cout << "Engine stop drains queue test passed\n";
+}
+
 int main() {
     try {
         testLimitOrderMatching();
         testMarketOrderMatching();
         testStopOrderTrigger();
+        testTriggeredStopMatches();
         testMultiLevelOrderBook();
+        testReplaceKeepsPriorityOnReduce();
+        testReplaceLosesPriority();
+        testReplaceCrossesAndMatches();
+        testReplaceUntriggeredStop();
+        testReplaceStopPriority();
+        testEngineReplaceTriggersStops();
+        testEngineStopDrainsQueue();
         
         std::cout << "All tests passed!\n";
         return 0;